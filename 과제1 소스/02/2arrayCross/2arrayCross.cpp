@@ -1,153 +1,195 @@
 ﻿
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
-#include <filesystem>   // C++17
-#include <cctype>       // isdigit
 #include <stdexcept>    // runtime_error, out_of_range
 #include <algorithm>    // std::min
+#include <chrono>
+#include <cstdio>       // printf
+#include <thread>
+
+#include "../../common/csvReader.h"
 
 using namespace std;
 namespace fs = std::filesystem;
 
-// ======================= CSVResult 구조체 =======================
-
-struct CSVResult {
-    vector<vector<int>> board; // CSV 데이터
-    size_t rows{ 0 };            // 행 개수
-    size_t cols{ 0 };            // 열 개수
-};
+// ======================= 도움말 출력 =======================
 
-// ======================= 유틸 함수들 =======================
+void print_help() {
+    cout << "사용법:\n"
+        << "  program -fn <csv 파일이름> -k <정수 k> [옵션]\n\n"
+        << "옵션:\n"
+        << "  -validate                     전체 파일을 병렬로 검증하고 모든 오류를 보고\n"
+        << "  -onerror <abort|skip|quarantine>  오류 행 처리 방법 (기본 abort)\n"
+        << "  -quarantine <파일>            오류 행을 기록할 파일 (-onerror quarantine)\n"
+        << "  -maxerr <개수>                보고할 최대 오류 개수 (기본 100)\n"
+        << "  -threads <개수>               검증 / 합계 스레드 수 (기본: 코어 수)\n"
+        << "  -nolimit                      100 x 100 크기 제한 해제\n"
+        << "  -bench                        스레드 수별 합계 속도 측정\n\n"
+        << "예시:\n"
+        << "  program -fn board_100x100.csv -k 5\n"
+        << "  program -fn board_100x100.csv -k 5 -validate -onerror skip\n"
+        << "  program -fn big_board.csv -k 5000 -nolimit -threads 8 -bench\n";
+}
 
-// 양쪽 공백 제거 함수
-string trim(const string& s) {
-    size_t start = s.find_first_not_of(" \t\r\n");
-    if (start == string::npos) {
-        return "";
+// ======================= solution 함수 =======================
+int solution(vector<vector<int>> board, int k) {
+    if (board.empty() || board[0].empty()) {
+        return 0;
     }
-    size_t end = s.find_last_not_of(" \t\r\n");
-    return s.substr(start, end - start + 1);
-}
 
-// 정수 문자열인지 검사 (선행 +, - 허용)
-bool isInteger(const string& s) {
-    if (s.empty()) return false;
+    size_t rows = board.size();
+    size_t cols = board[0].size();
 
-    size_t i = 0;
-    if (s[0] == '+' || s[0] == '-') {
-        if (s.size() == 1) return false; // "+"만 있는 경우 등
-        i = 1;
-    }
+    long long sum = 0;   // overflow 여유를 위해 long long 사용
 
-    for (; i < s.size(); ++i) {
-        if (!std::isdigit(static_cast<unsigned char>(s[i]))) {
-            return false;
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t col = 0; col < cols; ++col) {
+            int idx_sum = static_cast<int>(row + col);
+            if (idx_sum <= k) {        // 문제 조건: i + j <= k
+                sum += board[row][col];
+            }
         }
     }
-    return true;
+
+    return static_cast<int>(sum);
 }
 
-// ======================= CSV 읽기 =======================
+// ======================= 병렬 solution 함수 =======================
 
-CSVResult readCSV(const fs::path& filepath) {
-    CSVResult result;
+// 스레드별 누적값. 캐시 라인 하나를 통째로 차지해 false sharing 을 막는다
+struct alignas(64) PaddedSum {
+    long long value{ 0 };
+};
 
-    ifstream file(filepath);
-    if (!file.is_open()) {
-        throw runtime_error("Error: Cannot open file: " + filepath.string());
+// solution 과 같은 합을 여러 스레드로 계산하고 64 비트로 돌려준다.
+// 행 r 에서 더할 열은 min(cols, k - r + 1) 개뿐이므로, 그 개수를 가중치로
+// 0 .. min(rows - 1, k) 행을 작업량이 비슷한 구간으로 나눈다.
+// 스레드 하나가 맡을 원소가 minCellsPerThread 보다 적어지면 스레드 수를 줄이고,
+// 실제로 쓴 스레드 수는 usedThreads 로 알려 준다.
+constexpr size_t kMinCellsPerThread = 1 << 16;
+
+long long solutionParallel(const vector<vector<int>>& board, int k, unsigned threads,
+    unsigned* usedThreads = nullptr, size_t minCellsPerThread = kMinCellsPerThread)
+{
+    if (usedThreads) {
+        *usedThreads = 1;
+    }
+    if (board.empty() || board[0].empty() || k < 0) {
+        return 0;
     }
 
-    string line;
-    size_t lineNum = 0;
-
-    while (getline(file, line)) {
-        ++lineNum;
-        vector<int> row;
-        stringstream ss(line);
-        string token;
+    size_t cols = board[0].size();
+    size_t lastRow = std::min(board.size() - 1, static_cast<size_t>(k));
+    size_t nRows = lastRow + 1;
+
+    // 행 r 에서 더할 열 개수
+    auto rowWidth = [&](size_t r) {
+        return std::min(cols, static_cast<size_t>(k) - r + 1);
+    };
+
+    // weight[r] = 0 .. r-1 행의 누적 원소 수
+    vector<size_t> weight(nRows + 1, 0);
+    for (size_t r = 0; r < nRows; ++r) {
+        weight[r + 1] = weight[r] + rowWidth(r);
+    }
 
-        while (getline(ss, token, ',')) {
-            string t = trim(token);
+    // 작업량이 작으면 스레드 생성 비용이 더 크다
+    minCellsPerThread = std::max<size_t>(1, minCellsPerThread);
+    size_t nThreads = threads ? threads : std::thread::hardware_concurrency();
+    nThreads = std::max<size_t>(1, std::min({ nThreads, nRows, weight[nRows] / minCellsPerThread + 1 }));
+    if (usedThreads) {
+        *usedThreads = static_cast<unsigned>(nThreads);
+    }
 
-            // 빈 값이면 에러 (이 문제 조건은 모두 숫자)
-            if (t.empty()) {
-                throw runtime_error(
-                    "Error: Empty value at line " + to_string(lineNum)
-                );
-            }
+    // 누적 가중치가 t / nThreads 지점인 행을 경계로 삼는다
+    vector<size_t> bounds(nThreads + 1, nRows);
+    bounds[0] = 0;
+    for (size_t t = 1; t < nThreads; ++t) {
+        size_t target = weight[nRows] * t / nThreads;
+        bounds[t] = static_cast<size_t>(
+            lower_bound(weight.begin(), weight.end(), target) - weight.begin());
+        bounds[t] = std::max(bounds[t], bounds[t - 1]);
+    }
 
-            // 정수 형식 체크
-            if (!isInteger(t)) {
-                throw runtime_error(
-                    "Error: Non-integer token '" + t +
-                    "' at line " + to_string(lineNum)
-                );
+    vector<PaddedSum> sums(nThreads);
+    auto work = [&](size_t t) {
+        long long local = 0;
+        for (size_t r = bounds[t]; r < bounds[t + 1]; ++r) {
+            const int* row = board[r].data();
+            size_t width = rowWidth(r);
+            for (size_t c = 0; c < width; ++c) {
+                local += row[c];
             }
-
-            row.push_back(stoi(t));
         }
+        sums[t].value = local;
+    };
 
-        if (!row.empty()) {
-            // 첫 번째 유효한 줄에서 열 개수 결정
-            if (result.board.empty()) {
-                result.cols = row.size();
-            }
-            else {
-                // 이후 줄들은 열 개수가 동일해야 함
-                if (row.size() != result.cols) {
-                    throw runtime_error(
-                        "Error: Inconsistent column count at line " +
-                        to_string(lineNum)
-                    );
-                }
-            }
-
-            result.board.push_back(std::move(row));
+    {
+        vector<thread> workers;
+        for (size_t t = 1; t < nThreads; ++t) {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (auto& w : workers) {
+            w.join();
         }
     }
 
-    result.rows = result.board.size();
-
-    if (result.rows == 0 || result.cols == 0) {
-        throw runtime_error("Error: Empty CSV file or no valid data.");
+    // 항상 같은 순서로 합친다
+    long long sum = 0;
+    for (const PaddedSum& s : sums) {
+        sum += s.value;
     }
-
-    return result;
+    return sum;
 }
 
-// ======================= 도움말 출력 =======================
-
-void print_help() {
-    cout << "사용법:\n"
-        << "  program -fn <csv 파일이름> -k <정수 k>\n\n"
-        << "예시:\n"
-        << "  program -fn board_100x100.csv -k 5\n";
+// ======================= 스레드 확장성 벤치마크 =======================
+
+// fn 을 repeat 번 실행해 가장 빠른 시간(ms) 반환
+template <typename Fn>
+double bestTimeMs(Fn&& fn, int repeat) {
+    double best = 0;
+    for (int i = 0; i < repeat; ++i) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        auto end = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(end - start).count();
+        if (i == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
 }
 
-// ======================= solution 함수 =======================
-int solution(vector<vector<int>> board, int k) {
-    if (board.empty() || board[0].empty()) {
-        return 0;
+// 1, 2, 4, ... maxThreads 스레드로 solutionParallel 을 돌려 속도 비교.
+// 작은 보드에서도 요청한 스레드 수를 쓰도록 원소 수 하한은 끄고,
+// 행 수 때문에 실제로 줄어든 스레드 수는 used 열에 표시한다.
+void runBenchmark(const vector<vector<int>>& board, int k, unsigned maxThreads) {
+    constexpr int kRepeat = 5;
+    if (maxThreads == 0) {
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
     }
 
-    size_t rows = board.size();
-    size_t cols = board[0].size();
-
-    long long sum = 0;   // overflow 여유를 위해 long long 사용
+    long long expected = 0;
+    double base = bestTimeMs([&] { expected = solutionParallel(board, k, 1, nullptr, 1); }, kRepeat);
+
+    cout << "Benchmark (best of " << kRepeat << ")\n";
+    cout << "  threads  used  time(ms)  speedup\n";
+    for (unsigned t = 1; ; t = std::min(t * 2, maxThreads)) {
+        long long got = expected;
+        unsigned used = 1;
+        double ms = (t == 1) ? base
+            : bestTimeMs([&] { got = solutionParallel(board, k, t, &used, 1); }, kRepeat);
+        if (got != expected) {
+            throw runtime_error("벤치마크 결과 불일치 (threads = " + to_string(t) + ")");
+        }
+        printf("  %7u  %4u  %8.3f  %6.2fx\n", t, used, ms, ms > 0 ? base / ms : 0.0);
 
-    for (size_t row = 0; row < rows; ++row) {
-        for (size_t col = 0; col < cols; ++col) {
-            int idx_sum = static_cast<int>(row + col);
-            if (idx_sum <= k) {        // 문제 조건: i + j <= k
-                sum += board[row][col];
-            }
+        if (t == maxThreads) {
+            break;
         }
     }
-
-    return static_cast<int>(sum);
 }
 
 // ======================= main =======================
@@ -158,6 +200,12 @@ int main(int argc, char* argv[]) {
         int k = 0;
         bool hasFileName = false;
         bool hasK = false;
+        bool validate = false;
+        bool hasOnError = false;
+        bool noLimit = false;
+        bool bench = false;
+        unsigned threads = 0;
+        CSVValidateOptions validateOptions;
 
         // -------- 인자 파싱 --------
         for (int i = 1; i < argc; ++i) {
@@ -171,8 +219,36 @@ int main(int argc, char* argv[]) {
                 k = atoi(argv[++i]);
                 hasK = true;
             }
+            else if (arg == "-validate") {
+                validate = true;
+            }
+            else if (arg == "-onerror" && i + 1 < argc) {
+                if (!parseBadRowPolicy(argv[++i], validateOptions.policy)) {
+                    throw runtime_error("알 수 없는 -onerror 값: " + string(argv[i]));
+                }
+                hasOnError = true;
+                validate = true;
+            }
+            else if (arg == "-quarantine" && i + 1 < argc) {
+                validateOptions.quarantinePath = argv[++i];
+                validate = true;
+            }
+            else if (arg == "-maxerr" && i + 1 < argc) {
+                validateOptions.maxErrors = static_cast<size_t>(max(0, atoi(argv[++i])));
+            }
+            else if ((arg == "-threads" || arg == "--threads") && i + 1 < argc) {
+                threads = static_cast<unsigned>(max(0, atoi(argv[++i])));
+            }
+            else if (arg == "-nolimit") {
+                noLimit = true;
+            }
+            else if (arg == "-bench") {
+                bench = true;
+            }
         }
 
+        validateOptions.threads = threads;
+
         if (!hasFileName || !hasK) {
             print_help();
             if (!hasFileName) {
@@ -189,28 +265,56 @@ int main(int argc, char* argv[]) {
 
         fs::path csvPath = sFileName;
 
+        // -quarantine 은 인자 순서와 상관없이 격리 정책을 뜻한다
+        if (!validateOptions.quarantinePath.empty()) {
+            if (hasOnError && validateOptions.policy != BadRowPolicy::Quarantine) {
+                throw runtime_error("-quarantine 은 -onerror quarantine 외의 값과 함께 쓸 수 없음");
+            }
+            validateOptions.policy = BadRowPolicy::Quarantine;
+        }
+        if (validateOptions.policy == BadRowPolicy::Quarantine &&
+            validateOptions.quarantinePath.empty()) {
+            validateOptions.quarantinePath = csvPath;
+            validateOptions.quarantinePath += ".bad";
+        }
+
         // -------- CSV 읽기 --------
-        CSVResult csv = readCSV(csvPath);
+        CSVResult csv;
+        if (validate) {
+            CSVReport report;
+            CSVStatus status = readCSVValidated(csvPath, validateOptions, csv, report);
+            printReport(report, status);
+            if (status != CSVStatus::Ok && status != CSVStatus::RecoveredErrors) {
+                return 1;
+            }
+        }
+        else {
+            csv = readCSV(csvPath);
+        }
 
         cout << "Rows: " << csv.rows << "\n";
         cout << "Cols: " << csv.cols << "\n";
 
         // 문제 제한사항 체크
-        if (csv.rows > 100) {
+        if (!noLimit && csv.rows > 100) {
             throw runtime_error("행 크기가 100 초과: " + to_string(csv.rows));
         }
-        if (csv.cols > 100) {
+        if (!noLimit && csv.cols > 100) {
             throw runtime_error("열 크기가 100 초과: " + to_string(csv.cols));
         }
 
-        if (k >= static_cast<int>(csv.rows + csv.cols)) {
+        if (static_cast<size_t>(k) >= csv.rows + csv.cols) {
             cout << "경고: k 값이 rows + cols 보다 크거나 같습니다. "
                 << "어차피 모든 원소가 포함됩니다.\n";
         }
 
         // -------- solution 호출 --------
-        int ans = solution(csv.board, k);
+        long long ans = solutionParallel(csv.board, k, threads);
         cout << "sum(i + j <= " << k << ") = " << ans << "\n";
+
+        if (bench) {
+            runBenchmark(csv.board, k, threads);
+        }
     }
     catch (const exception& e) {
         cerr << "Exception: " << e.what() << "\n";
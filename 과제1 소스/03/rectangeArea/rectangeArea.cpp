@@ -1,155 +1,581 @@
 ﻿#include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
-#include <filesystem>   // C++17
-#include <cctype>       // isdigit
 #include <stdexcept>    // runtime_error, out_of_range
 #include <algorithm>    // std::min
+#include <chrono>
+#include <cmath>        // sqrt, ceil
+#include <cstdint>      // uint32_t
+#include <cstdio>       // printf
+#include <thread>
+
+#include "../../common/csvReader.h"
 
 using namespace std;
 namespace fs = std::filesystem;
 
-// ======================= CSVResult 구조체 =======================
+// ======================= 도움말 출력 =======================
 
-struct CSVResult {
-    vector<vector<int>> board; // CSV 데이터
-    size_t rows{ 0 };            // 행 개수
-    size_t cols{ 0 };            // 열 개수
+void print_help() {
+    cout << "사용법:\n"
+        << "  program <csv 파일이름> [옵션]\n\n"
+        << "옵션:\n"
+        << "  -validate                     전체 파일을 병렬로 검증하고 모든 오류를 보고\n"
+        << "  -onerror <abort|skip|quarantine>  오류 행 처리 방법 (기본 abort)\n"
+        << "  -quarantine <파일>            오류 행을 기록할 파일 (-onerror quarantine)\n"
+        << "  -maxerr <개수>                보고할 최대 오류 개수 (기본 100)\n"
+        << "  -union                        4행씩 묶인 여러 사각형의 합집합 넓이 계산\n"
+        << "  -points <csv>                 각 점 (x,y) 을 포함하는 사각형 찾기\n"
+        << "  -boxes <csv>                  각 사각형 (4행) 과 겹치는 사각형 찾기\n"
+        << "                                (-union / -points / -boxes 중 하나만 지정)\n"
+        << "  -bench                        -points / -boxes 질의를 전체 탐색과 속도 비교\n"
+        << "  -threads <개수>               검증 / 합집합 / 질의 스레드 수 (기본: 코어 수)\n\n"
+        << "예시:\n"
+        << "  program  rectange_4x2.csv \n"
+        << "  program  rectange_4x2.csv -validate -onerror skip\n"
+        << "  program  rects.csv -union -threads 8\n"
+        << "  program  rects.csv -points points.csv -bench\n";
+}
+
+// ======================= 사각형 정규화 =======================
+
+// 축에 평행한 사각형 (x1 <= x2, y1 <= y2)
+struct Rect {
+    int x1{ 0 };
+    int y1{ 0 };
+    int x2{ 0 };
+    int y2{ 0 };
 };
 
-// ======================= 유틸 함수들 =======================
+// dots[first .. first+3] 네 점을 감싸는 사각형 (min / max 로 정규화)
+Rect boundingRect(const vector<vector<int>>& dots, size_t first) {
+    Rect r{ dots[first][0], dots[first][1], dots[first][0], dots[first][1] };
+
+    for (size_t i = first + 1; i < first + 4; ++i)
+    {
+        r.x1 = min(r.x1, dots[i][0]);
+        r.x2 = max(r.x2, dots[i][0]);
+        r.y1 = min(r.y1, dots[i][1]);
+        r.y2 = max(r.y2, dots[i][1]);
+    }
+    return r;
+}
+
+// 4행씩 묶인 점 목록을 사각형 목록으로 변환
+vector<Rect> toRects(const vector<vector<int>>& dots) {
+    vector<Rect> rects;
+    rects.reserve(dots.size() / 4);
+    for (size_t i = 0; i + 4 <= dots.size(); i += 4) {
+        rects.push_back(boundingRect(dots, i));
+    }
+    return rects;
+}
+
+// 여러 사각형 입력(4행씩)을 사각형 목록으로 변환.
+// -onerror skip / quarantine 으로 오류 행이 빠졌으면 뒤의 묶음이 밀리지 않도록
+// 원본 데이터 행 번호(dataRowIds)로 4행 묶음을 다시 맞추고,
+// 한 행이라도 빠진 묶음은 통째로 버린 뒤 그 개수를 droppedGroups 로 알려 준다.
+// groupIds 를 주면 rects[i] 가 원본의 몇 번째 사각형인지 채운다.
+vector<Rect> toRectsByGroup(const CSVResult& csv, size_t& droppedGroups,
+    vector<uint32_t>* groupIds = nullptr)
+{
+    droppedGroups = 0;
+    if (groupIds) {
+        groupIds->clear();
+    }
+    if (csv.cols != 2) {
+        throw runtime_error("열 크기가 2 가 아님: " + to_string(csv.cols));
+    }
+
+    if (csv.dataRowIds.empty()) {
+        if (csv.rows % 4 != 0) {
+            throw runtime_error("행 크기가 4 의 배수가 아님: " + to_string(csv.rows));
+        }
+        return toRects(csv.board);
+    }
+
+    if (csv.dataRows % 4 != 0) {
+        throw runtime_error("행 크기가 4 의 배수가 아님: " + to_string(csv.dataRows));
+    }
 
-// 양쪽 공백 제거 함수
-string trim(const string& s) {
-    size_t start = s.find_first_not_of(" \t\r\n");
-    if (start == string::npos) {
-        return "";
+    const vector<size_t>& ids = csv.dataRowIds;
+    vector<Rect> rects;
+    rects.reserve(csv.board.size() / 4);
+    for (size_t i = 0; i < ids.size(); ) {
+        size_t group = ids[i] / 4;
+        size_t end = i;
+        while (end < ids.size() && ids[end] / 4 == group) {
+            ++end;
+        }
+        if (end - i == 4) {
+            rects.push_back(boundingRect(csv.board, i));
+            if (groupIds) {
+                groupIds->push_back(static_cast<uint32_t>(group));
+            }
+        }
+        i = end;
     }
-    size_t end = s.find_last_not_of(" \t\r\n");
-    return s.substr(start, end - start + 1);
+    droppedGroups = csv.dataRows / 4 - rects.size();
+    return rects;
 }
 
-// 정수 문자열인지 검사 (선행 +, - 허용)
-bool isInteger(const string& s) {
-    if (s.empty()) return false;
+// ======================= solution 함수 =======================
+int solution(vector<vector<int>> dots) {
+    if ((dots.size() != 4) || (dots[0].size() != 2)) {
+        return 0;
+    }
+
+    Rect r = boundingRect(dots, 0);
+
+    int width = std::abs(r.x2 - r.x1);
+    int height = std::abs(r.y2 - r.y1);
+
+    
+    return width * height;
+}
+
+// ======================= 합집합 넓이 (sweep line) =======================
+
+namespace {
+
+// 압축된 y 좌표 위의 덮임 횟수 세그먼트 트리.
+// 노드는 [ys[lo], ys[hi]) 구간을 맡고, 덮인 길이를 len 에 유지한다.
+class CoverTree {
+public:
+    explicit CoverTree(const vector<int>& ys)
+        : ys_(ys), cnt_(4 * ys.size(), 0), len_(4 * ys.size(), 0) {}
+
+    // ys[l] ~ ys[r] 구간에 delta (+1 / -1) 적용
+    void update(size_t l, size_t r, int delta) {
+        if (l < r) {
+            update(1, 0, ys_.size() - 1, l, r, delta);
+        }
+    }
+
+    long long covered() const { return len_[1]; }
+
+private:
+    void update(size_t node, size_t lo, size_t hi, size_t l, size_t r, int delta) {
+        if (r <= lo || hi <= l) {
+            return;
+        }
+        if (l <= lo && hi <= r) {
+            cnt_[node] += delta;
+        }
+        else {
+            size_t mid = (lo + hi) / 2;
+            update(2 * node, lo, mid, l, r, delta);
+            update(2 * node + 1, mid, hi, l, r, delta);
+        }
 
-    size_t i = 0;
-    if (s[0] == '+' || s[0] == '-') {
-        if (s.size() == 1) return false; // "+"만 있는 경우 등
-        i = 1;
+        if (cnt_[node] > 0) {
+            len_[node] = static_cast<long long>(ys_[hi]) - ys_[lo];
+        }
+        else if (hi - lo == 1) {
+            len_[node] = 0;
+        }
+        else {
+            len_[node] = len_[2 * node] + len_[2 * node + 1];
+        }
     }
 
-    for (; i < s.size(); ++i) {
-        if (!std::isdigit(static_cast<unsigned char>(s[i]))) {
-            return false;
+    const vector<int>& ys_;
+    vector<int> cnt_;
+    vector<long long> len_;
+};
+
+// [xLo, xHi) 세로 띠 안에서의 합집합 넓이
+long long sweepSlab(const vector<Rect>& rects, int xLo, int xHi) {
+    struct Event {
+        int x;
+        int delta;
+        int y1;
+        int y2;
+    };
+
+    vector<Event> events;
+    vector<int> ys;
+    for (const Rect& r : rects) {
+        int a = max(r.x1, xLo);
+        int b = min(r.x2, xHi);
+        if (a >= b || r.y1 >= r.y2) {
+            continue;
         }
+        events.push_back({ a, +1, r.y1, r.y2 });
+        events.push_back({ b, -1, r.y1, r.y2 });
+        ys.push_back(r.y1);
+        ys.push_back(r.y2);
     }
-    return true;
+    if (events.empty()) {
+        return 0;
+    }
+
+    sort(ys.begin(), ys.end());
+    ys.erase(unique(ys.begin(), ys.end()), ys.end());
+    sort(events.begin(), events.end(),
+        [](const Event& a, const Event& b) { return a.x < b.x; });
+
+    auto yIndex = [&](int y) {
+        return static_cast<size_t>(lower_bound(ys.begin(), ys.end(), y) - ys.begin());
+    };
+
+    CoverTree tree(ys);
+    long long area = 0;
+    int prevX = events[0].x;
+    for (const Event& e : events) {
+        area += tree.covered() * (static_cast<long long>(e.x) - prevX);
+        tree.update(yIndex(e.y1), yIndex(e.y2), e.delta);
+        prevX = e.x;
+    }
+    return area;
 }
 
-// ======================= CSV 읽기 =======================
+} // namespace
+
+// 겹칠 수 있는 사각형들이 덮는 전체 넓이. O(n log n)
+// x 축을 사각형 경계 개수가 비슷한 띠(slab)로 나눠 스레드마다 따로 sweep 한다.
+long long unionArea(const vector<Rect>& rects, unsigned threads) {
+    vector<int> xs;
+    xs.reserve(rects.size() * 2);
+    for (const Rect& r : rects) {
+        if (r.x1 < r.x2 && r.y1 < r.y2) {
+            xs.push_back(r.x1);
+            xs.push_back(r.x2);
+        }
+    }
+    if (xs.empty()) {
+        return 0;
+    }
+    sort(xs.begin(), xs.end());
+
+    // 띠가 너무 얇으면 사각형 복제 비용이 더 크다
+    constexpr size_t kMinRectsPerSlab = 1 << 14;
+    size_t nSlabs = threads ? threads : std::thread::hardware_concurrency();
+    nSlabs = std::max<size_t>(1, std::min(nSlabs, rects.size() / kMinRectsPerSlab + 1));
+
+    vector<int> bounds;
+    for (size_t k = 0; k <= nSlabs; ++k) {
+        bounds.push_back(xs[k * (xs.size() - 1) / nSlabs]);
+    }
+    bounds.erase(unique(bounds.begin(), bounds.end()), bounds.end());
+    if (bounds.size() < 2) {
+        return 0;
+    }
 
-CSVResult readCSV(const fs::path& filepath) {
-    CSVResult result;
+    vector<long long> partial(bounds.size() - 1, 0);
+    {
+        vector<thread> workers;
+        for (size_t s = 1; s < partial.size(); ++s) {
+            workers.emplace_back([&, s] {
+                partial[s] = sweepSlab(rects, bounds[s], bounds[s + 1]);
+            });
+        }
+        partial[0] = sweepSlab(rects, bounds[0], bounds[1]);
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
 
-    ifstream file(filepath);
-    if (!file.is_open()) {
-        throw runtime_error("Error: Cannot open file: " + filepath.string());
+    long long total = 0;
+    for (long long a : partial) {
+        total += a;
     }
+    return total;
+}
 
-    string line;
-    size_t lineNum = 0;
+// ======================= 공간 인덱스 (R-tree) =======================
 
-    while (getline(file, line)) {
-        ++lineNum;
-        vector<int> row;
-        stringstream ss(line);
-        string token;
+// 두 사각형이 겹치는지 (경계만 닿아도 겹친 것으로 본다)
+inline bool overlaps(const Rect& a, const Rect& b) {
+    return a.x1 <= b.x2 && b.x1 <= a.x2 && a.y1 <= b.y2 && b.y1 <= a.y2;
+}
 
-        while (getline(ss, token, ',')) {
-            string t = trim(token);
+// STR(Sort-Tile-Recursive) 로 한 번에 만드는 정적 R-tree.
+// 노드는 레벨 순서로 하나의 배열에 저장되고(잎 먼저, 루트 마지막),
+// 자식과 잎 항목은 항상 연속 구간(first, count) 이라 포인터를 따라가지 않는다.
+class RectIndex {
+public:
+    explicit RectIndex(const vector<Rect>& rects, size_t nodeCapacity = 16)
+        : capacity_(std::max<size_t>(2, nodeCapacity)) {
+        if (rects.size() > UINT32_MAX) {
+            throw runtime_error("사각형이 너무 많음: " + to_string(rects.size()));
+        }
 
-            // 빈 값이면 에러 (이 문제 조건은 모두 숫자)
-            if (t.empty()) {
-                throw runtime_error(
-                    "Error: Empty value at line " + to_string(lineNum)
-                );
+        // -------- 잎 항목 정렬 --------
+        vector<Entry> entries(rects.size());
+        for (size_t i = 0; i < rects.size(); ++i) {
+            entries[i] = { rects[i], static_cast<uint32_t>(i) };
+        }
+        strSort(entries);
+
+        boxes_.reserve(entries.size());
+        ids_.reserve(entries.size());
+        for (const Entry& e : entries) {
+            boxes_.push_back(e.box);
+            ids_.push_back(e.id);
+        }
+
+        // -------- 잎 노드 --------
+        vector<Node> level;
+        for (size_t first = 0; first < boxes_.size(); first += capacity_) {
+            level.push_back(makeNode(boxes_, first, std::min(capacity_, boxes_.size() - first)));
+        }
+        leafCount_ = level.size();
+
+        // -------- 위쪽 레벨 --------
+        // 레벨마다 STR 로 정렬한 뒤 연속한 capacity_ 개씩 부모로 묶는다
+        while (!level.empty()) {
+            strSort(level);
+            size_t base = nodes_.size();
+            nodes_.insert(nodes_.end(), level.begin(), level.end());
+            if (level.size() == 1) {
+                break;
             }
 
-            // 정수 형식 체크
-            if (!isInteger(t)) {
-                throw runtime_error(
-                    "Error: Non-integer token '" + t +
-                    "' at line " + to_string(lineNum)
-                );
+            vector<Node> parents;
+            vector<Rect> childBoxes;
+            childBoxes.reserve(level.size());
+            for (const Node& n : level) {
+                childBoxes.push_back(n.box);
+            }
+            for (size_t first = 0; first < level.size(); first += capacity_) {
+                size_t count = std::min(capacity_, level.size() - first);
+                Node parent = makeNode(childBoxes, first, count);
+                parent.first = static_cast<uint32_t>(base + first);
+                parents.push_back(parent);
             }
+            level = std::move(parents);
+        }
+    }
+
+    size_t size() const { return ids_.size(); }
 
-            row.push_back(stoi(t));
+    // box 와 겹치는 사각형 번호마다 onHit(id) 호출
+    template <typename Fn>
+    void query(const Rect& box, Fn&& onHit) const {
+        if (nodes_.empty()) {
+            return;
         }
 
-        if (!row.empty()) {
-            // 첫 번째 유효한 줄에서 열 개수 결정
-            if (result.board.empty()) {
-                result.cols = row.size();
+        vector<uint32_t>& stack = scratch();
+        stack.clear();
+        stack.push_back(static_cast<uint32_t>(nodes_.size() - 1));
+
+        while (!stack.empty()) {
+            const Node& node = nodes_[stack.back()];
+            bool leaf = stack.back() < leafCount_;
+            stack.pop_back();
+
+            if (!overlaps(node.box, box)) {
+                continue;
+            }
+            if (leaf) {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    if (overlaps(boxes_[i], box)) {
+                        onHit(ids_[i]);
+                    }
+                }
             }
             else {
-                // 이후 줄들은 열 개수가 동일해야 함
-                if (row.size() != result.cols) {
-                    throw runtime_error(
-                        "Error: Inconsistent column count at line " +
-                        to_string(lineNum)
-                    );
+                for (uint32_t c = node.first; c < node.first + node.count; ++c) {
+                    stack.push_back(c);
                 }
             }
+        }
+    }
 
-            result.board.push_back(std::move(row));
+private:
+    struct Entry {
+        Rect box;
+        uint32_t id;
+    };
+
+    struct Node {
+        Rect box;             // 자식 전체를 감싸는 사각형
+        uint32_t first{ 0 };  // 잎: boxes_ 시작 위치, 내부: nodes_ 시작 위치
+        uint32_t count{ 0 };
+    };
+
+    static const Rect& boxOf(const Rect& r) { return r; }
+    static const Rect& boxOf(const Entry& e) { return e.box; }
+    static const Rect& boxOf(const Node& n) { return n.box; }
+
+    // 중심 좌표 (2 배) — int 범위를 넘지 않게 long long 사용
+    static long long centerX(const Rect& r) { return static_cast<long long>(r.x1) + r.x2; }
+    static long long centerY(const Rect& r) { return static_cast<long long>(r.y1) + r.y2; }
+
+    // 연속한 capacity_ 개씩 묶었을 때 공간적으로 가깝도록 정렬.
+    // x 중심으로 정렬해 sqrt(P) 개의 세로 띠로 나누고, 띠마다 y 중심으로 정렬한다.
+    template <typename T>
+    void strSort(vector<T>& items) const {
+        auto byX = [](const T& a, const T& b) { return centerX(boxOf(a)) < centerX(boxOf(b)); };
+        auto byY = [](const T& a, const T& b) { return centerY(boxOf(a)) < centerY(boxOf(b)); };
+
+        size_t pages = (items.size() + capacity_ - 1) / capacity_;
+        size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(pages))));
+        size_t sliceSize = std::max<size_t>(1, slices) * capacity_;
+
+        sort(items.begin(), items.end(), byX);
+        for (size_t s = 0; s < items.size(); s += sliceSize) {
+            auto end = items.begin() + std::min(items.size(), s + sliceSize);
+            sort(items.begin() + s, end, byY);
         }
     }
 
-    result.rows = result.board.size();
+    Node makeNode(const vector<Rect>& boxes, size_t first, size_t count) const {
+        Node n;
+        n.box = boxes[first];
+        for (size_t i = first + 1; i < first + count; ++i) {
+            n.box.x1 = min(n.box.x1, boxes[i].x1);
+            n.box.y1 = min(n.box.y1, boxes[i].y1);
+            n.box.x2 = max(n.box.x2, boxes[i].x2);
+            n.box.y2 = max(n.box.y2, boxes[i].y2);
+        }
+        n.first = static_cast<uint32_t>(first);
+        n.count = static_cast<uint32_t>(count);
+        return n;
+    }
 
-    if (result.rows == 0 || result.cols == 0) {
-        throw runtime_error("Error: Empty CSV file or no valid data.");
+    // 스레드마다 따로 쓰는 탐색 스택 (질의 중 할당을 피한다)
+    static vector<uint32_t>& scratch() {
+        thread_local vector<uint32_t> stack;
+        return stack;
     }
 
+    size_t capacity_;
+    size_t leafCount_{ 0 };
+    vector<Node> nodes_;
+    vector<Rect> boxes_;     // STR 순서로 정렬된 잎 항목
+    vector<uint32_t> ids_;   // boxes_[i] 의 원래 사각형 번호
+};
+
+// 질의 결과 (CSR 형식): 질의 q 의 결과는 ids[offsets[q] .. offsets[q+1])
+struct QueryResult {
+    vector<size_t> offsets;
+    vector<uint32_t> ids;
+};
+
+// 질의들을 스레드 수만큼 연속 구간으로 나눠 처리하고 질의 순서대로 합친다.
+// search(box, out) 은 box 와 겹치는 사각형 번호를 out 에 추가한다.
+template <typename Search>
+QueryResult runQueries(const vector<Rect>& queries, unsigned threads, Search&& search) {
+    size_t nThreads = threads ? threads : std::thread::hardware_concurrency();
+    nThreads = std::max<size_t>(1, std::min(nThreads, queries.size()));
+
+    vector<QueryResult> parts(nThreads);
+    auto work = [&](size_t t) {
+        size_t begin = queries.size() * t / nThreads;
+        size_t end = queries.size() * (t + 1) / nThreads;
+        QueryResult& part = parts[t];
+        for (size_t q = begin; q < end; ++q) {
+            part.offsets.push_back(part.ids.size());
+            search(queries[q], part.ids);
+        }
+    };
+
+    {
+        vector<thread> workers;
+        for (size_t t = 1; t < nThreads; ++t) {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    QueryResult result;
+    result.offsets.reserve(queries.size() + 1);
+    for (QueryResult& part : parts) {
+        size_t base = result.ids.size();
+        for (size_t off : part.offsets) {
+            result.offsets.push_back(base + off);
+        }
+        result.ids.insert(result.ids.end(), part.ids.begin(), part.ids.end());
+    }
+    result.offsets.push_back(result.ids.size());
     return result;
 }
 
-// ======================= 도움말 출력 =======================
+// R-tree 로 질의
+QueryResult queryIndex(const RectIndex& index, const vector<Rect>& queries, unsigned threads) {
+    return runQueries(queries, threads, [&](const Rect& box, vector<uint32_t>& out) {
+        index.query(box, [&](uint32_t id) { out.push_back(id); });
+    });
+}
 
-void print_help() {
-    cout << "사용법:\n"
-        << "  program <csv 파일이름> \n\n"
-        << "예시:\n"
-        << "  program  rectange_4x2.csv \n";
+// 모든 사각형을 훑는 비교용 질의
+QueryResult queryBruteForce(const vector<Rect>& rects, const vector<Rect>& queries, unsigned threads) {
+    return runQueries(queries, threads, [&](const Rect& box, vector<uint32_t>& out) {
+        for (size_t i = 0; i < rects.size(); ++i) {
+            if (overlaps(rects[i], box)) {
+                out.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    });
 }
 
-// ======================= solution 함수 =======================
-int solution(vector<vector<int>> dots) {
-    if ((dots.size() != 4) || (dots[0].size() != 2)) {
-        return 0;
-    }
+// 질의 결과 요약 출력 (처음 몇 개 질의만 번호 목록 출력)
+void printQueryResult(const QueryResult& result, size_t maxShown) {
+    size_t nQueries = result.offsets.size() - 1;
+    cout << "Queries: " << nQueries << ", matches: " << result.ids.size() << "\n";
 
-    int minX = dots[0][0];
-    int maxX = dots[0][0];
-    int minY = dots[0][1];
-    int maxY = dots[0][1];
+    for (size_t q = 0; q < std::min(nQueries, maxShown); ++q) {
+        vector<uint32_t> hits(result.ids.begin() + result.offsets[q],
+            result.ids.begin() + result.offsets[q + 1]);
+        sort(hits.begin(), hits.end());
 
-    for (size_t i = 1; i < dots.size(); ++i)
-    {
-        minX = min(minX, dots[i][0]);
-        maxX = max(maxX, dots[i][0]);
-        minY = min(minY, dots[i][1]);
-        maxY = max(maxY, dots[i][1]);
+        cout << "  query " << q << ": [";
+        for (size_t i = 0; i < hits.size(); ++i) {
+            if (i > 0) cout << ", ";
+            cout << hits[i];
+        }
+        cout << "]\n";
     }
+}
 
-    int width = std::abs(maxX - minX);
-    int height = std::abs(maxY - minY);
+// fn 을 repeat 번 실행해 가장 빠른 시간(ms)을 반환
+template <typename Fn>
+double bestTimeMs(Fn&& fn, int repeat) {
+    double best = 0;
+    for (int i = 0; i < repeat; ++i) {
+        auto start = chrono::steady_clock::now();
+        fn();
+        auto end = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(end - start).count();
+        if (i == 0 || ms < best) { best = ms; }
+    }
+    return best;
+}
 
-    
-    return width * height;
+// R-tree 와 전체 탐색의 초당 질의 수 비교 (각각 5회 중 최고 기록)
+void runQueryBenchmark(const RectIndex& index, const vector<Rect>& rects,
+    const vector<Rect>& queries, unsigned threads)
+{
+    constexpr int kRepeat = 5;
+
+    // 첫 실행에서 생기는 thread_local 탐색 스택 할당과 캐시 적재는 측정에서 제외
+    QueryResult tree = queryIndex(index, queries, threads);
+    QueryResult brute = queryBruteForce(rects, queries, threads);
+    double treeMs = bestTimeMs([&] { tree = queryIndex(index, queries, threads); }, kRepeat);
+    double bruteMs = bestTimeMs([&] { brute = queryBruteForce(rects, queries, threads); }, kRepeat);
+
+    // 질의별 결과 집합이 같은지 확인 (순서는 다를 수 있음)
+    for (size_t q = 0; q + 1 < tree.offsets.size(); ++q) {
+        vector<uint32_t> a(tree.ids.begin() + tree.offsets[q], tree.ids.begin() + tree.offsets[q + 1]);
+        vector<uint32_t> b(brute.ids.begin() + brute.offsets[q], brute.ids.begin() + brute.offsets[q + 1]);
+        sort(a.begin(), a.end());
+        sort(b.begin(), b.end());
+        if (a != b) {
+            throw runtime_error("R-tree 결과가 전체 탐색과 다름 (query " + to_string(q) + ")");
+        }
+    }
+
+    auto qps = [&](double ms) { return ms > 0 ? static_cast<double>(queries.size()) * 1000 / ms : 0.0; };
+    printf("Benchmark (%zu queries, best of %d)\n", queries.size(), kRepeat);
+    printf("  R-tree      : %10.3f ms  %14.0f queries/s\n", treeMs, qps(treeMs));
+    printf("  brute force : %10.3f ms  %14.0f queries/s\n", bruteMs, qps(bruteMs));
+    printf("  speedup     : %10.2fx\n", treeMs > 0 ? bruteMs / treeMs : 0.0);
 }
 
 // ======================= main =======================
@@ -158,6 +584,14 @@ int main(int argc, char* argv[]) {
     try {
         string sFileName;
         bool hasFileName = false;
+        bool validate = false;
+        bool hasOnError = false;
+        bool unionMode = false;
+        bool bench = false;
+        unsigned threads = 0;
+        string pointsFile;
+        string boxesFile;
+        CSVValidateOptions validateOptions;
 
         // -------- 인자 파싱 --------
         if (argc > 1)
@@ -166,15 +600,145 @@ int main(int argc, char* argv[]) {
             hasFileName = true;
         }
 
+        for (int i = 2; i < argc; ++i) {
+            string arg = argv[i];
+
+            if (arg == "-validate") {
+                validate = true;
+            }
+            else if (arg == "-union") {
+                unionMode = true;
+            }
+            else if (arg == "-points" && i + 1 < argc) {
+                pointsFile = argv[++i];
+            }
+            else if (arg == "-boxes" && i + 1 < argc) {
+                boxesFile = argv[++i];
+            }
+            else if (arg == "-bench") {
+                bench = true;
+            }
+            else if (arg == "-onerror" && i + 1 < argc) {
+                if (!parseBadRowPolicy(argv[++i], validateOptions.policy)) {
+                    throw runtime_error("알 수 없는 -onerror 값: " + string(argv[i]));
+                }
+                hasOnError = true;
+                validate = true;
+            }
+            else if (arg == "-quarantine" && i + 1 < argc) {
+                validateOptions.quarantinePath = argv[++i];
+                validate = true;
+            }
+            else if (arg == "-maxerr" && i + 1 < argc) {
+                validateOptions.maxErrors = static_cast<size_t>(max(0, atoi(argv[++i])));
+            }
+            else if ((arg == "-threads" || arg == "--threads") && i + 1 < argc) {
+                threads = static_cast<unsigned>(max(0, atoi(argv[++i])));
+            }
+        }
+        validateOptions.threads = threads;
+
         if (!hasFileName) {
             print_help();
             throw runtime_error("csv 파일 명이 없음");
         }
 
+        // 실행 모드는 하나만 고를 수 있다
+        if (!pointsFile.empty() && !boxesFile.empty()) {
+            throw runtime_error("-points 와 -boxes 는 함께 쓸 수 없음");
+        }
+        if (unionMode && (!pointsFile.empty() || !boxesFile.empty())) {
+            throw runtime_error("-union 은 -points / -boxes 와 함께 쓸 수 없음");
+        }
+
         fs::path csvPath = sFileName;
 
+        // -quarantine 은 인자 순서와 상관없이 격리 정책을 뜻한다
+        if (!validateOptions.quarantinePath.empty()) {
+            if (hasOnError && validateOptions.policy != BadRowPolicy::Quarantine) {
+                throw runtime_error("-quarantine 은 -onerror quarantine 외의 값과 함께 쓸 수 없음");
+            }
+            validateOptions.policy = BadRowPolicy::Quarantine;
+        }
+        if (validateOptions.policy == BadRowPolicy::Quarantine &&
+            validateOptions.quarantinePath.empty()) {
+            validateOptions.quarantinePath = csvPath;
+            validateOptions.quarantinePath += ".bad";
+        }
+
         // -------- CSV 읽기 --------
-        CSVResult csv = readCSV(csvPath);
+        CSVResult csv;
+        if (validate) {
+            CSVReport report;
+            CSVStatus status = readCSVValidated(csvPath, validateOptions, csv, report);
+            printReport(report, status);
+            if (status != CSVStatus::Ok && status != CSVStatus::RecoveredErrors) {
+                return 1;
+            }
+        }
+        else {
+            csv = readCSV(csvPath);
+        }
+
+        // -------- 공간 질의 모드 --------
+        if (!pointsFile.empty() || !boxesFile.empty()) {
+            size_t droppedGroups = 0;
+            vector<uint32_t> groupIds;
+            vector<Rect> rects = toRectsByGroup(csv, droppedGroups, &groupIds);
+            if (droppedGroups > 0) {
+                cout << "Dropped rectangles (오류 행 포함): " << droppedGroups << "\n";
+            }
+            CSVResult queryCsv = readCSV(pointsFile.empty() ? boxesFile : pointsFile);
+            if (queryCsv.cols != 2) {
+                throw runtime_error("질의 파일 열 크기가 2 가 아님: " + to_string(queryCsv.cols));
+            }
+
+            // 점 (x, y) 는 크기 0 인 사각형으로 질의한다
+            vector<Rect> queries;
+            if (!pointsFile.empty()) {
+                queries.reserve(queryCsv.rows);
+                for (const auto& p : queryCsv.board) {
+                    queries.push_back({ p[0], p[1], p[0], p[1] });
+                }
+            }
+            else {
+                if (queryCsv.rows % 4 != 0) {
+                    throw runtime_error("질의 파일 행 크기가 4 의 배수가 아님: " + to_string(queryCsv.rows));
+                }
+                queries = toRects(queryCsv.board);
+            }
+
+            RectIndex index(rects);
+            cout << "Rectangles: " << index.size() << "\n";
+
+            QueryResult result = queryIndex(index, queries, threads);
+
+            // 결과 번호는 건너뛴 묶음과 상관없이 원본 파일의 사각형 번호로 출력한다
+            if (!groupIds.empty()) {
+                for (uint32_t& id : result.ids) {
+                    id = groupIds[id];
+                }
+            }
+            printQueryResult(result, 10);
+
+            if (bench) {
+                runQueryBenchmark(index, rects, queries, threads);
+            }
+            return 0;
+        }
+
+        // -------- 합집합 모드 --------
+        if (unionMode) {
+            size_t droppedGroups = 0;
+            vector<Rect> rects = toRectsByGroup(csv, droppedGroups);
+            if (droppedGroups > 0) {
+                cout << "Dropped rectangles (오류 행 포함): " << droppedGroups << "\n";
+            }
+            long long area = unionArea(rects, threads);
+            cout << "Rectangles: " << rects.size() << "\n";
+            cout << "Union area = " << area << "\n";
+            return 0;
+        }
 
         // 문제 제한사항 체크
         if (csv.rows != 4) {
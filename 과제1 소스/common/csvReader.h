@@ -0,0 +1,990 @@
+﻿#pragma once
+
+// 2arrayCross / rectangeArea 가 같이 쓰는 정수 CSV 읽기
+//  - readCSV          : 첫 오류에서 runtime_error 를 던지는 기본 읽기
+//  - readCSVValidated : 예외 없이 병렬로 전체를 검증하는 읽기
+//  - gzip / zstd 압축 입력은 magic bytes 로 판별해 바로 풀면서 읽는다
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <filesystem>   // C++17
+#include <cctype>       // isdigit
+#include <stdexcept>    // runtime_error, out_of_range
+#include <algorithm>    // std::min
+#include <charconv>     // from_chars
+#include <deque>
+#include <memory>       // unique_ptr
+#include <string_view>
+#include <thread>
+
+// gzip / zstd 입력 지원은 빌드할 때 명시적으로 켠다 (라이브러리를 링크해야 함)
+//   g++         : -DCSV_WITH_ZLIB ... -lz   /   -DCSV_WITH_ZSTD ... -lzstd
+//   Visual Studio: 전처리기 정의에 CSV_WITH_ZLIB / CSV_WITH_ZSTD 추가,
+//                  링커 입력에 zlib.lib / zstd.lib 추가 (예: vcpkg)
+// 정의하지 않으면 해당 형식의 파일은 "지원되지 않음" 오류로 처리한다.
+#ifdef CSV_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CSV_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// ======================= CSVResult 구조체 =======================
+
+struct CSVResult {
+    std::vector<std::vector<int>> board; // CSV 데이터
+    size_t rows{ 0 };            // 행 개수
+    size_t cols{ 0 };            // 열 개수
+
+    // readCSVValidated 만 채움: 오류 행을 건너뛰어도 원래 몇 번째 행이었는지 알 수 있게
+    std::vector<size_t> dataRowIds;  // board[i] 의 원본 데이터 행 번호 (빈 줄 제외, 0부터)
+    size_t dataRows{ 0 };            // 오류 행을 포함한 원본 데이터 행 수
+};
+
+// ======================= 유틸 함수들 =======================
+
+// 양쪽 공백 제거 함수
+inline std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(start, end - start + 1);
+}
+
+// 정수 문자열인지 검사 (선행 +, - 허용)
+inline bool isInteger(const std::string& s) {
+    if (s.empty()) return false;
+
+    size_t i = 0;
+    if (s[0] == '+' || s[0] == '-') {
+        if (s.size() == 1) return false; // "+"만 있는 경우 등
+        i = 1;
+    }
+
+    for (; i < s.size(); ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(s[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ======================= 압축 입력 스트리밍 =======================
+//
+// 입력 파일 앞의 magic bytes 로 압축 형식을 판별하고, 고정 크기 블록 단위로
+// 압축을 풀면서 바로 파서에 넘긴다. 풀린 파일을 디스크에 쓰지 않는다.
+//  - gzip : 1f 8b          (CSV_WITH_ZLIB 빌드만, multi-member 지원)
+//  - zstd : 28 b5 2f fd    (CSV_WITH_ZSTD 빌드만, 여러 frame 은 병렬로 풀기)
+
+inline constexpr size_t kBlockBytes = 1 << 20;  // 한 번에 읽고 푸는 블록 크기
+
+enum class Compression { None, Gzip, Zstd };
+
+inline Compression detectCompression(const unsigned char* magic, size_t n) {
+    if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        return Compression::Gzip;
+    }
+    if (n >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 &&
+        magic[2] == 0x2f && magic[3] == 0xfd) {
+        return Compression::Zstd;
+    }
+    return Compression::None;
+}
+
+// 바이트 스트림 입력. 오류는 예외 대신 error() 에 남긴다.
+class ByteSource {
+public:
+    virtual ~ByteSource() = default;
+
+    // 최대 n 바이트를 dst 에 채우고 실제 바이트 수 반환 (0 이면 끝 또는 오류)
+    virtual size_t read(char* dst, size_t n) = 0;
+
+    bool failed() const { return !error_.empty(); }
+    const std::string& error() const { return error_; }
+
+protected:
+    std::string error_;
+};
+
+namespace csv_detail {
+
+// 압축되지 않은 파일
+class PlainSource : public ByteSource {
+public:
+    explicit PlainSource(std::ifstream file) : file_(std::move(file)) {}
+
+    size_t read(char* dst, size_t n) override {
+        file_.read(dst, static_cast<std::streamsize>(n));
+        return static_cast<size_t>(file_.gcount());
+    }
+
+private:
+    std::ifstream file_;
+};
+
+// 해당 형식을 지원하지 않는 빌드
+class UnsupportedSource : public ByteSource {
+public:
+    explicit UnsupportedSource(const std::string& format) {
+        error_ = format + " 압축 입력은 이 빌드에서 지원되지 않음";
+    }
+
+    size_t read(char*, size_t) override { return 0; }
+};
+
+#ifdef CSV_WITH_ZLIB
+class GzipSource : public ByteSource {
+public:
+    explicit GzipSource(std::ifstream file) : file_(std::move(file)), in_(kBlockBytes) {
+        // 15 + 32 : gzip / zlib 헤더 자동 판별
+        if (inflateInit2(&zs_, 15 + 32) != Z_OK) {
+            error_ = "gzip 초기화 실패";
+            return;
+        }
+        initialized_ = true;
+    }
+
+    ~GzipSource() override {
+        if (initialized_) {
+            inflateEnd(&zs_);
+        }
+    }
+
+    size_t read(char* dst, size_t n) override {
+        if (failed() || done_) {
+            return 0;
+        }
+
+        zs_.next_out = reinterpret_cast<Bytef*>(dst);
+        zs_.avail_out = static_cast<uInt>(std::min<size_t>(n, kBlockBytes));
+        size_t requested = zs_.avail_out;
+
+        while (zs_.avail_out > 0) {
+            if (zs_.avail_in == 0) {
+                file_.read(in_.data(), static_cast<std::streamsize>(in_.size()));
+                size_t got = static_cast<size_t>(file_.gcount());
+                if (got == 0) {
+                    if (!memberEnded_) {
+                        error_ = "gzip 입력이 중간에 끝남";
+                    }
+                    done_ = true;
+                    break;
+                }
+                zs_.next_in = reinterpret_cast<Bytef*>(in_.data());
+                zs_.avail_in = static_cast<uInt>(got);
+            }
+
+            int rc = inflate(&zs_, Z_NO_FLUSH);
+            if (rc == Z_STREAM_END) {
+                // 뒤에 다른 gzip member 가 이어질 수 있다
+                memberEnded_ = true;
+                inflateReset(&zs_);
+                continue;
+            }
+            if (rc != Z_OK) {
+                error_ = "gzip 압축 해제 실패 (" + std::to_string(rc) + ")";
+                break;
+            }
+            memberEnded_ = false;
+        }
+
+        return requested - zs_.avail_out;
+    }
+
+private:
+    std::ifstream file_;
+    std::vector<char> in_;
+    z_stream zs_{};
+    bool initialized_{ false };
+    bool memberEnded_{ false };
+    bool done_{ false };
+};
+#endif // CSV_WITH_ZLIB
+
+#ifdef CSV_WITH_ZSTD
+// 여러 frame 으로 된 zstd 파일은 풀린 크기가 헤더에 적힌 작은 frame 들을 모아
+// 스레드별로 동시에 푼다. 크기를 모르거나 큰 frame 은 블록 단위 스트리밍으로 푼다.
+class ZstdSource : public ByteSource {
+public:
+    ZstdSource(std::ifstream file, unsigned threads)
+        : file_(std::move(file)),
+        threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+        dctx_(ZSTD_createDCtx()) {
+        if (!dctx_) {
+            error_ = "zstd 초기화 실패";
+        }
+    }
+
+    ~ZstdSource() override {
+        ZSTD_freeDCtx(dctx_);
+    }
+
+    size_t read(char* dst, size_t n) override {
+        size_t written = 0;
+        while (written < n && !failed()) {
+            if (!ready_.empty()) {
+                const std::string& front = ready_.front();
+                size_t take = std::min(n - written, front.size() - readyPos_);
+                std::copy_n(front.data() + readyPos_, take, dst + written);
+                written += take;
+                readyPos_ += take;
+                if (readyPos_ == front.size()) {
+                    ready_.pop_front();
+                    readyPos_ = 0;
+                }
+                continue;
+            }
+            if (!decodeMore()) {
+                break;
+            }
+        }
+        return written;
+    }
+
+private:
+    // 완성된 frame 을 찾을 때 버퍼에 쌓아 둘 최대 압축 바이트
+    static constexpr size_t kMaxBufferedBytes = 32 * kBlockBytes;
+    // 병렬로 풀 frame 하나 / 한 묶음의 최대 풀린 크기
+    static constexpr size_t kMaxFrameBytes = 8 * kBlockBytes;
+    static constexpr size_t kMaxBatchBytes = 64 * kBlockBytes;
+
+    // 압축 입력을 한 블록 더 읽기. 더 없으면 false
+    bool readInput() {
+        if (eof_) {
+            return false;
+        }
+        size_t old = in_.size();
+        in_.resize(old + kBlockBytes);
+        file_.read(in_.data() + old, static_cast<std::streamsize>(kBlockBytes));
+        size_t got = static_cast<size_t>(file_.gcount());
+        in_.resize(old + got);
+        if (got == 0) {
+            eof_ = true;
+        }
+        return got > 0;
+    }
+
+    void compactInput() {
+        if (inPos_ > 0) {
+            in_.erase(0, inPos_);
+            inPos_ = 0;
+        }
+    }
+
+    // frame 하나를 미리 잡아 둔 크기(contentSize) 의 out 에 풀기
+    static bool decodeFrame(ZSTD_DCtx* dctx, const char* src, size_t size,
+        size_t contentSize, std::string& out) {
+        out.resize(contentSize);
+        size_t rc = ZSTD_decompressDCtx(dctx, out.data(), out.size(), src, size);
+        return !ZSTD_isError(rc) && rc == contentSize;
+    }
+
+    // 다음 출력 덩어리를 ready_ 에 준비. 입력 끝이나 오류면 false
+    bool decodeMore() {
+        if (streaming_) {
+            return streamStep();
+        }
+
+        compactInput();
+
+        // -------- 완성된 frame 모으기 --------
+        // 헤더에 풀린 크기가 적혀 있고 kMaxFrameBytes 이하인 frame 만 모으며,
+        // 한 번에 풀 전체 크기도 kMaxBatchBytes 를 넘지 않게 한다.
+        std::vector<std::pair<size_t, size_t>> frames;  // (offset, size)
+        std::vector<size_t> contentSizes;
+        size_t batchBytes = 0;
+        size_t off = 0;
+        bool streamNext = false;  // 맨 앞 frame 이 크기를 모르거나 너무 큼
+        while (frames.size() < 2 * static_cast<size_t>(threads_)) {
+            if (off == in_.size()) {
+                if ((!frames.empty() && in_.size() >= kMaxBufferedBytes) || !readInput()) {
+                    break;
+                }
+                continue;
+            }
+            size_t fsz = ZSTD_findFrameCompressedSize(in_.data() + off, in_.size() - off);
+            if (!ZSTD_isError(fsz)) {
+                unsigned long long content = ZSTD_getFrameContentSize(in_.data() + off, fsz);
+                if (content == ZSTD_CONTENTSIZE_UNKNOWN || content == ZSTD_CONTENTSIZE_ERROR ||
+                    content > kMaxFrameBytes) {
+                    streamNext = frames.empty();
+                    break;
+                }
+                if (batchBytes + content > kMaxBatchBytes) {
+                    break;
+                }
+                frames.emplace_back(off, fsz);
+                contentSizes.push_back(static_cast<size_t>(content));
+                batchBytes += static_cast<size_t>(content);
+                off += fsz;
+                continue;
+            }
+            // 아직 덜 읽은 frame: 이미 모은 frame 이 있거나 너무 크면 그만 모은다
+            if (!frames.empty() || in_.size() - off >= kMaxBufferedBytes || !readInput()) {
+                break;
+            }
+        }
+
+        if (frames.empty()) {
+            if (in_.empty() && eof_) {
+                return false;  // 정상 종료
+            }
+            if (!streamNext && eof_) {
+                error_ = "zstd 입력이 손상되었거나 중간에 끝남";
+                return false;
+            }
+            // 크기를 모르거나 큰 frame: 블록 단위 스트리밍으로 푼다
+            ZSTD_DCtx_reset(dctx_, ZSTD_reset_session_only);
+            streaming_ = true;
+            return streamStep();
+        }
+
+        // -------- frame 병렬 해제 (스레드마다 DCtx 하나) --------
+        std::vector<std::string> decoded(frames.size());
+        std::vector<char> ok(frames.size(), 0);
+        size_t nWorkers = std::min<size_t>(threads_, frames.size());
+        auto work = [&](size_t t) {
+            ZSTD_DCtx* dctx = ZSTD_createDCtx();
+            if (!dctx) {
+                return;
+            }
+            for (size_t f = t; f < frames.size(); f += nWorkers) {
+                ok[f] = decodeFrame(dctx, in_.data() + frames[f].first, frames[f].second,
+                    contentSizes[f], decoded[f]);
+            }
+            ZSTD_freeDCtx(dctx);
+        };
+        {
+            std::vector<std::thread> workers;
+            for (size_t t = 1; t < nWorkers; ++t) {
+                workers.emplace_back(work, t);
+            }
+            work(0);
+            for (auto& w : workers) {
+                w.join();
+            }
+        }
+
+        for (size_t f = 0; f < frames.size(); ++f) {
+            if (!ok[f]) {
+                error_ = "zstd 압축 해제 실패";
+                return false;
+            }
+            if (!decoded[f].empty()) {
+                ready_.push_back(std::move(decoded[f]));
+            }
+        }
+        inPos_ = off;
+        return true;
+    }
+
+    // 큰 frame 에서 출력 블록 하나 풀기
+    bool streamStep() {
+        std::string block(ZSTD_DStreamOutSize(), '\0');
+        ZSTD_outBuffer ob{ block.data(), block.size(), 0 };
+
+        while (ob.pos == 0) {
+            if (inPos_ == in_.size()) {
+                compactInput();
+                if (!readInput()) {
+                    error_ = "zstd 입력이 중간에 끝남";
+                    return false;
+                }
+            }
+            ZSTD_inBuffer ib{ in_.data() + inPos_, in_.size() - inPos_, 0 };
+            size_t rc = ZSTD_decompressStream(dctx_, &ob, &ib);
+            inPos_ += ib.pos;
+            if (ZSTD_isError(rc)) {
+                error_ = std::string("zstd 압축 해제 실패: ") + ZSTD_getErrorName(rc);
+                return false;
+            }
+            if (rc == 0) {
+                streaming_ = false;  // frame 끝
+                break;
+            }
+        }
+
+        block.resize(ob.pos);
+        if (!block.empty()) {
+            ready_.push_back(std::move(block));
+        }
+        return true;
+    }
+
+    std::ifstream file_;
+    unsigned threads_;
+    ZSTD_DCtx* dctx_;
+    std::string in_;                // 아직 풀지 않은 압축 입력
+    size_t inPos_{ 0 };
+    bool eof_{ false };
+    bool streaming_{ false };
+    std::deque<std::string> ready_;      // 풀린 데이터
+    size_t readyPos_{ 0 };
+};
+#endif // CSV_WITH_ZSTD
+
+} // namespace csv_detail
+
+// 파일을 열고 압축 형식에 맞는 ByteSource 생성. 열기 실패 시 nullptr
+inline std::unique_ptr<ByteSource> openByteSource(const fs::path& filepath, unsigned threads) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    unsigned char magic[4] = {};
+    file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+    size_t n = static_cast<size_t>(file.gcount());
+    file.clear();
+    file.seekg(0, std::ios::beg);
+
+    switch (detectCompression(magic, n)) {
+    case Compression::Gzip:
+#ifdef CSV_WITH_ZLIB
+        return std::make_unique<csv_detail::GzipSource>(std::move(file));
+#else
+        return std::make_unique<csv_detail::UnsupportedSource>("gzip");
+#endif
+    case Compression::Zstd:
+#ifdef CSV_WITH_ZSTD
+        return std::make_unique<csv_detail::ZstdSource>(std::move(file), threads);
+#else
+        (void)threads;
+        return std::make_unique<csv_detail::UnsupportedSource>("zstd");
+#endif
+    case Compression::None:
+        break;
+    }
+    return std::make_unique<csv_detail::PlainSource>(std::move(file));
+}
+
+// ByteSource 위에서 getline 과 같은 방식으로 줄 읽기.
+// 파일은 binary 로 열리므로 Windows 의 text mode 처럼 줄 끝 '\r' 하나를 떼어 낸다.
+// 입력이 실패하면 (손상, 잘린 압축 파일) 남은 조각을 넘기지 않고 false 를 반환한다.
+class LineReader {
+public:
+    explicit LineReader(ByteSource& source) : source_(source) {}
+
+    bool getline(std::string& line) {
+        line.clear();
+        bool any = false;
+        while (true) {
+            if (pos_ < buf_.size()) {
+                any = true;
+                size_t nl = buf_.find('\n', pos_);
+                if (nl != std::string::npos) {
+                    line.append(buf_, pos_, nl - pos_);
+                    pos_ = nl + 1;
+                    stripCR(line);
+                    return true;
+                }
+                line.append(buf_, pos_, std::string::npos);
+                pos_ = buf_.size();
+            }
+
+            buf_.resize(kBlockBytes);
+            buf_.resize(source_.read(buf_.data(), buf_.size()));
+            pos_ = 0;
+            if (source_.failed()) {
+                buf_.clear();
+                line.clear();
+                return false;
+            }
+            if (buf_.empty()) {
+                stripCR(line);
+                return any;
+            }
+        }
+    }
+
+private:
+    static void stripCR(std::string& line) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+    }
+
+    ByteSource& source_;
+    std::string buf_;
+    size_t pos_{ 0 };
+};
+
+// ======================= CSV 읽기 =======================
+
+inline CSVResult readCSV(const fs::path& filepath) {
+    CSVResult result;
+
+    std::unique_ptr<ByteSource> source = openByteSource(filepath, 0);
+    if (!source) {
+        throw std::runtime_error("Error: Cannot open file: " + filepath.string());
+    }
+    LineReader reader(*source);
+
+    std::string line;
+    size_t lineNum = 0;
+
+    while (reader.getline(line)) {
+        ++lineNum;
+        std::vector<int> row;
+        std::stringstream ss(line);
+        std::string token;
+
+        while (std::getline(ss, token, ',')) {
+            std::string t = trim(token);
+
+            // 빈 값이면 에러 (이 문제 조건은 모두 숫자)
+            if (t.empty()) {
+                throw std::runtime_error(
+                    "Error: Empty value at line " + std::to_string(lineNum)
+                );
+            }
+
+            // 정수 형식 체크
+            if (!isInteger(t)) {
+                throw std::runtime_error(
+                    "Error: Non-integer token '" + t +
+                    "' at line " + std::to_string(lineNum)
+                );
+            }
+
+            row.push_back(std::stoi(t));
+        }
+
+        if (!row.empty()) {
+            // 첫 번째 유효한 줄에서 열 개수 결정
+            if (result.board.empty()) {
+                result.cols = row.size();
+            }
+            else {
+                // 이후 줄들은 열 개수가 동일해야 함
+                if (row.size() != result.cols) {
+                    throw std::runtime_error(
+                        "Error: Inconsistent column count at line " +
+                        std::to_string(lineNum)
+                    );
+                }
+            }
+
+            result.board.push_back(std::move(row));
+        }
+    }
+
+    if (source->failed()) {
+        throw std::runtime_error("Error: " + source->error());
+    }
+
+    result.rows = result.board.size();
+
+    if (result.rows == 0 || result.cols == 0) {
+        throw std::runtime_error("Error: Empty CSV file or no valid data.");
+    }
+
+    return result;
+}
+
+// ======================= CSV 검증 모드 (예외 없음) =======================
+//
+// readCSV 는 첫 번째 오류에서 바로 예외를 던지므로 큰 파일은 오류 한 줄마다
+// 다시 실행해야 한다. readCSVValidated 는 파일 전체를 병렬 청크로 한 번에
+// 검사하고, 예외 대신 상태 코드와 오류 보고서(CSVReport)를 돌려준다.
+
+// 검증 중 발견된 오류 종류
+enum class CSVErrorKind {
+    EmptyValue,      // 빈 토큰
+    NonInteger,      // 정수가 아닌 토큰
+    OutOfRange,      // int 범위를 벗어난 정수
+    ColumnMismatch,  // 첫 번째 유효 행과 열 개수가 다름
+};
+
+// readCSVValidated 반환 상태 코드
+enum class CSVStatus {
+    Ok,                // 오류 없음
+    RecoveredErrors,   // 오류 행을 건너뛰거나 격리하고 나머지를 읽음
+    InvalidRows,       // 오류가 있어 데이터를 버림 (Abort 정책)
+    OpenFailed,        // 입력 파일 열기 실패
+    DecompressFailed,  // 압축 해제 실패 (손상, 미지원 형식)
+    QuarantineFailed,  // 격리 파일 쓰기 실패
+    EmptyData,         // 유효한 데이터 없음
+};
+
+// 오류 행 처리 정책
+enum class BadRowPolicy {
+    Abort,       // 오류를 모두 보고하고 데이터는 버림
+    Skip,        // 오류 행만 빼고 계속
+    Quarantine,  // 오류 행을 격리 파일에 원문 그대로 기록하고 계속
+};
+
+struct CSVError {
+    size_t line{ 0 };    // 1부터 시작하는 줄 번호
+    size_t column{ 0 };  // 1부터 시작하는 열 번호 (ColumnMismatch 는 실제 열 개수)
+    CSVErrorKind kind{ CSVErrorKind::EmptyValue };
+};
+
+struct CSVValidateOptions {
+    BadRowPolicy policy{ BadRowPolicy::Abort };
+    size_t maxErrors{ 100 };  // 보고서에 담을 최대 오류 개수
+    unsigned threads{ 0 };    // 0 이면 hardware_concurrency 사용
+    fs::path quarantinePath;  // Quarantine 정책에서 오류 행을 기록할 파일
+};
+
+struct CSVReport {
+    std::vector<CSVError> errors;  // 줄 순서대로 최대 maxErrors 개
+    size_t totalErrors{ 0 };  // 실제로 발견된 전체 오류 개수
+    size_t badRows{ 0 };      // 오류가 하나 이상 있는 행 개수
+    size_t totalLines{ 0 };   // 읽은 전체 줄 수
+};
+
+inline const char* toString(CSVErrorKind kind) {
+    switch (kind) {
+    case CSVErrorKind::EmptyValue:     return "empty value";
+    case CSVErrorKind::NonInteger:     return "non-integer token";
+    case CSVErrorKind::OutOfRange:     return "integer out of range";
+    case CSVErrorKind::ColumnMismatch: return "inconsistent column count";
+    }
+    return "unknown";
+}
+
+inline const char* toString(CSVStatus status) {
+    switch (status) {
+    case CSVStatus::Ok:               return "ok";
+    case CSVStatus::RecoveredErrors:  return "recovered (bad rows skipped or quarantined)";
+    case CSVStatus::InvalidRows:      return "invalid rows";
+    case CSVStatus::OpenFailed:       return "cannot open file";
+    case CSVStatus::DecompressFailed: return "cannot decompress input";
+    case CSVStatus::QuarantineFailed: return "cannot write quarantine file";
+    case CSVStatus::EmptyData:        return "empty CSV file or no valid data";
+    }
+    return "unknown";
+}
+
+namespace csv_detail {
+
+// 청크 하나에서 파싱한 줄 (빈 줄은 저장하지 않음)
+struct ParsedLine {
+    size_t line{ 0 };         // 청크 내부 줄 번호 (0부터)
+    std::string_view text;         // 원문 (격리 파일 기록용)
+    std::vector<int> values;
+    size_t errorCount{ 0 };   // 이 줄의 토큰 오류 개수
+};
+
+struct ChunkResult {
+    std::vector<ParsedLine> lines;
+    std::vector<CSVError> errors;  // line 은 청크 내부 번호, 최대 maxErrors 개
+    size_t lineCount{ 0 };
+};
+
+inline std::string_view trimView(std::string_view s) {
+    size_t start = s.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(start, end - start + 1);
+}
+
+// 예외 없이 토큰 하나를 int 로 변환 (선행 +, - 허용)
+inline bool parseIntToken(std::string_view t, int& value, CSVErrorKind& kind) {
+    if (t.empty()) {
+        kind = CSVErrorKind::EmptyValue;
+        return false;
+    }
+
+    std::string_view digits = t;
+    if (digits[0] == '+' || digits[0] == '-') {
+        digits.remove_prefix(1);
+    }
+    if (digits.empty()) {
+        kind = CSVErrorKind::NonInteger;
+        return false;
+    }
+    for (char ch : digits) {
+        if (!std::isdigit(static_cast<unsigned char>(ch))) {
+            kind = CSVErrorKind::NonInteger;
+            return false;
+        }
+    }
+
+    // from_chars 는 '+' 를 받지 않으므로 부호가 '+' 이면 떼고 넘긴다
+    std::string_view number = (t[0] == '+') ? digits : t;
+    auto [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), value);
+    if (ec != std::errc{} || ptr != number.data() + number.size()) {
+        kind = CSVErrorKind::OutOfRange;
+        return false;
+    }
+    return true;
+}
+
+// [begin, end) 구간을 줄 단위로 파싱. readCSV 와 같은 규칙을 따른다.
+//  - 빈 줄은 무시
+//  - 줄 끝의 ',' 하나는 getline 과 마찬가지로 무시
+inline ChunkResult parseChunk(std::string_view chunk, size_t maxErrors) {
+    ChunkResult out;
+    size_t pos = 0;
+
+    while (pos < chunk.size()) {
+        size_t eol = chunk.find('\n', pos);
+        if (eol == std::string_view::npos) {
+            eol = chunk.size();
+        }
+        std::string_view lineText = chunk.substr(pos, eol - pos);
+        size_t lineIdx = out.lineCount++;
+        pos = eol + 1;
+
+        // CRLF 줄 끝은 LineReader 와 같이 '\r' 하나를 뗀다 (빈 CRLF 줄은 빈 줄)
+        if (!lineText.empty() && lineText.back() == '\r') {
+            lineText.remove_suffix(1);
+        }
+
+        if (lineText.empty()) {
+            continue;
+        }
+
+        ParsedLine parsed;
+        parsed.line = lineIdx;
+        parsed.text = lineText;
+
+        size_t fieldStart = 0;
+        size_t column = 0;
+        while (fieldStart < lineText.size()) {
+            size_t comma = lineText.find(',', fieldStart);
+            if (comma == std::string_view::npos) {
+                comma = lineText.size();
+            }
+            ++column;
+
+            int value = 0;
+            CSVErrorKind kind{};
+            if (parseIntToken(trimView(lineText.substr(fieldStart, comma - fieldStart)), value, kind)) {
+                parsed.values.push_back(value);
+            }
+            else {
+                ++parsed.errorCount;
+                if (out.errors.size() < maxErrors) {
+                    out.errors.push_back({ lineIdx, column, kind });
+                }
+            }
+            fieldStart = comma + 1;
+        }
+
+        out.lines.push_back(std::move(parsed));
+    }
+
+    return out;
+}
+
+// 버퍼를 줄 경계에 맞춰 nChunks 개로 나눈다
+inline std::vector<std::string_view> splitChunks(std::string_view data, size_t nChunks) {
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    for (size_t i = 1; i <= nChunks && begin < data.size(); ++i) {
+        size_t end = (i == nChunks) ? data.size() : data.size() * i / nChunks;
+        if (end < begin) {
+            end = begin;
+        }
+        size_t nl = data.find('\n', end);
+        end = (nl == std::string_view::npos || i == nChunks) ? data.size() : nl + 1;
+        chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+// 버퍼를 병렬로 나눠 파싱
+inline std::vector<ChunkResult> parseParallel(std::string_view data, size_t threads, size_t maxErrors) {
+    // 청크가 너무 작으면 스레드 생성 비용이 더 크다
+    constexpr size_t kMinChunkBytes = 1 << 16;
+    size_t nThreads = threads ? threads : std::thread::hardware_concurrency();
+    nThreads = std::max<size_t>(1, std::min(nThreads, data.size() / kMinChunkBytes + 1));
+
+    std::vector<std::string_view> chunks = splitChunks(data, nThreads);
+    std::vector<ChunkResult> parsed(chunks.size());
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back([&, i] {
+            parsed[i] = parseChunk(chunks[i], maxErrors);
+        });
+    }
+    if (!chunks.empty()) {
+        parsed[0] = parseChunk(chunks[0], maxErrors);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return parsed;
+}
+
+} // namespace csv_detail
+
+inline CSVStatus readCSVValidated(const fs::path& filepath,
+    const CSVValidateOptions& options,
+    CSVResult& result,
+    CSVReport& report)
+{
+    result = CSVResult{};
+    report = CSVReport{};
+
+    std::unique_ptr<ByteSource> source = openByteSource(filepath, options.threads);
+    if (!source) {
+        return CSVStatus::OpenFailed;
+    }
+
+    // 압축 해제된 데이터를 이 크기의 창(window) 단위로 모아 병렬 파싱한다
+    constexpr size_t kWindowBytes = 64 * kBlockBytes;
+
+    auto addError = [&](size_t line, size_t column, CSVErrorKind kind) {
+        ++report.totalErrors;
+        if (report.errors.size() < options.maxErrors) {
+            report.errors.push_back({ line, column, kind });
+        }
+    };
+
+    // 격리 파일은 시작할 때 비워 두어, 이전 실행의 오류 행이 남지 않게 한다
+    std::ofstream quarantine;
+    bool quarantineFailed = false;
+    if (options.policy == BadRowPolicy::Quarantine) {
+        quarantine.open(options.quarantinePath, std::ios::binary | std::ios::trunc);
+        if (!quarantine.is_open()) {
+            return CSVStatus::QuarantineFailed;
+        }
+    }
+    auto markBad = [&](std::string_view text) {
+        ++report.badRows;
+        if (options.policy == BadRowPolicy::Abort) {
+            // 어차피 데이터는 버리므로 더 쌓지 않는다
+            result.board.clear();
+            result.board.shrink_to_fit();
+            result.dataRowIds.clear();
+            result.dataRowIds.shrink_to_fit();
+        }
+        else if (options.policy == BadRowPolicy::Quarantine && !quarantineFailed) {
+            quarantine.write(text.data(), static_cast<std::streamsize>(text.size()));
+            quarantine.put('\n');
+            quarantineFailed = !quarantine;
+        }
+    };
+
+    std::string window;
+    std::string carry;   // 창 끝에서 잘린 마지막 줄
+    bool eof = false;
+    size_t lineBase = 0;
+
+    while (!eof) {
+        // -------- 창 채우기 --------
+        // 잘린 줄을 넘겨받았더라도 항상 kWindowBytes 만큼은 새로 읽는다
+        window.swap(carry);
+        carry.clear();
+        size_t fillTo = window.size() + kWindowBytes;
+        while (window.size() < fillTo) {
+            size_t old = window.size();
+            window.resize(old + kBlockBytes);
+            size_t got = source->read(window.data() + old, kBlockBytes);
+            window.resize(old + got);
+            if (got == 0) {
+                eof = true;
+                break;
+            }
+        }
+        if (source->failed()) {
+            return CSVStatus::DecompressFailed;
+        }
+
+        if (!eof) {
+            size_t lastNl = window.rfind('\n');
+            if (lastNl == std::string::npos) {
+                carry.swap(window);  // 창보다 긴 줄: 더 읽는다
+                continue;
+            }
+            carry.assign(window, lastNl + 1, std::string::npos);
+            window.resize(lastNl + 1);
+        }
+
+        std::vector<csv_detail::ChunkResult> parsed = csv_detail::parseParallel(window, options.threads, options.maxErrors);
+
+        // -------- 줄 순서대로 병합 --------
+        for (csv_detail::ChunkResult& chunk : parsed) {
+            size_t errCursor = 0;
+            for (csv_detail::ParsedLine& pl : chunk.lines) {
+                size_t lineNum = lineBase + pl.line + 1;
+                size_t dataRowId = result.dataRows++;
+
+                if (pl.errorCount > 0) {
+                    size_t stored = std::min(pl.errorCount, chunk.errors.size() - errCursor);
+                    for (size_t e = 0; e < stored; ++e) {
+                        const CSVError& err = chunk.errors[errCursor++];
+                        addError(lineNum, err.column, err.kind);
+                    }
+                    report.totalErrors += pl.errorCount - stored;
+                    markBad(pl.text);
+                    continue;
+                }
+
+                // 첫 번째 유효한 줄에서 열 개수 결정
+                if (result.cols == 0) {
+                    result.cols = pl.values.size();
+                }
+                else if (pl.values.size() != result.cols) {
+                    addError(lineNum, pl.values.size(), CSVErrorKind::ColumnMismatch);
+                    markBad(pl.text);
+                    continue;
+                }
+
+                if (report.badRows == 0 || options.policy != BadRowPolicy::Abort) {
+                    result.board.push_back(std::move(pl.values));
+                    result.dataRowIds.push_back(dataRowId);
+                }
+            }
+            lineBase += chunk.lineCount;
+        }
+    }
+    report.totalLines = lineBase;
+
+    if (report.badRows > 0) {
+        if (options.policy == BadRowPolicy::Abort) {
+            result = CSVResult{};
+            return CSVStatus::InvalidRows;
+        }
+        if (quarantineFailed) {
+            return CSVStatus::QuarantineFailed;
+        }
+    }
+
+    result.rows = result.board.size();
+    if (result.rows == 0 || result.cols == 0) {
+        return CSVStatus::EmptyData;
+    }
+
+    return report.badRows > 0 ? CSVStatus::RecoveredErrors : CSVStatus::Ok;
+}
+
+// 검증 보고서 출력
+inline void printReport(const CSVReport& report, CSVStatus status) {
+    std::cout << "Validation: " << toString(status) << "\n"
+        << "  lines: " << report.totalLines
+        << ", bad rows: " << report.badRows
+        << ", errors: " << report.totalErrors << "\n";
+
+    for (const CSVError& err : report.errors) {
+        std::cout << "  line " << err.line << ", column " << err.column
+            << ": " << toString(err.kind) << "\n";
+    }
+    if (report.totalErrors > report.errors.size()) {
+        std::cout << "  ... " << (report.totalErrors - report.errors.size())
+            << " more error(s) not shown\n";
+    }
+}
+
+// "-onerror" 인자 해석
+inline bool parseBadRowPolicy(const std::string& s, BadRowPolicy& policy) {
+    if (s == "abort")      { policy = BadRowPolicy::Abort;      return true; }
+    if (s == "skip")       { policy = BadRowPolicy::Skip;       return true; }
+    if (s == "quarantine") { policy = BadRowPolicy::Quarantine; return true; }
+    return false;
+}